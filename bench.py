@@ -0,0 +1,190 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+USAGE_EXAMPLES = """\
+examples:
+  ./bench.py
+  ./bench.py --scenario replay --scenario duel --repeats 5
+  ./bench.py --update-baseline"""
+
+# Every scenario is a config passed to the launcher and the bench strategies it runs.
+# Bench strategies (strategies/bench_*) are wrapped into BenchStrategy from include/bench_strategy.h
+# and dump their stats to build/bench/<strategy>.perf_stats.json, the day is fixed in their configs.
+# The Python strategy can't be instrumented, so only wall time and peak RSS are measured for it.
+SCENARIOS = [
+    ('replay', 'strategies/bench_replay/bench_replay.json', ['bench_replay']),
+    ('requote', 'strategies/bench_requote/bench_requote.json', ['bench_requote']),
+    ('depth_scan', 'strategies/bench_depth_scan/bench_depth_scan.json', ['bench_depth_scan']),
+    ('duel', 'bench_duel_config.json', ['bench_requote', 'bench_depth_scan']),
+    ('python', 'strategies/python_strategy/python_strategy.json', []),
+]
+
+# Metrics which are compared with the baseline, the lower value is the better one.
+COMPARED_METRICS = ['wall_time_s', 'ns_per_book_update', 'peak_rss_kb']
+
+pack_path = os.path.dirname(os.path.realpath(__file__))
+work_dir = os.path.join(pack_path, 'build', 'bench')
+
+parser = argparse.ArgumentParser(epilog=USAGE_EXAMPLES, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--scenario', action='append', choices=[name for name, _, _ in SCENARIOS],
+                    help='scenario to run, all scenarios are run by default')
+parser.add_argument('--repeats', type=int, default=3, help='runs of every scenario, the fastest one is reported')
+parser.add_argument('--tolerance', type=float, default=0.1,
+                    help='allowed relative growth of a metric over the baseline')
+parser.add_argument('--baseline', default=os.path.join(pack_path, 'bench_baseline.json'), help='baseline file')
+parser.add_argument('--output', default=os.path.join(work_dir, 'results.json'), help='file to write results to')
+parser.add_argument('--update-baseline', action='store_true', help='overwrite the baseline with the results')
+args = parser.parse_args()
+
+system = platform.system()
+if system == 'Linux':
+    executable_name = 'linux_launcher'
+elif system == 'Darwin':
+    executable_name = 'mac_launcher'
+elif system == 'Windows':
+    executable_name = 'windows_launcher.exe'
+else:
+    print('Your OS is not supported')
+    sys.exit(1)
+
+executable_path = os.path.join(pack_path, executable_name)
+env = dict(os.environ, PYTHONPATH=".")
+
+
+def launch(config_path, log_path):
+    # Returns the exit code and peak RSS of the launcher in kilobytes, or None if the OS doesn't report it.
+    with open(log_path, 'w') as log_file:
+        process = subprocess.Popen([executable_path, config_path], cwd=pack_path, shell=False,
+                                   stdout=log_file, stderr=subprocess.STDOUT, env=env)
+        if not hasattr(os, 'wait4'):
+            return process.wait(), None
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else 1
+    # ru_maxrss is in bytes on macOS and in kilobytes on Linux.
+    return process.returncode, usage.ru_maxrss // 1024 if system == 'Darwin' else usage.ru_maxrss
+
+
+def perf_stats_path(strategy):
+    return os.path.join(work_dir, strategy + '.perf_stats.json')
+
+
+def read_perf_stats(strategies):
+    stats = {}
+    for strategy in strategies:
+        if not os.path.exists(perf_stats_path(strategy)):
+            print('-- Bench FAILED: %s is not written, is %s built?' % (perf_stats_path(strategy), strategy))
+            sys.exit(1)
+        with open(perf_stats_path(strategy)) as stats_file:
+            stats[strategy] = json.load(stats_file)
+    return stats
+
+
+def run_scenario(name, config_path, strategies):
+    with open(os.path.join(pack_path, config_path)) as config_file:
+        result = {'config': config_path, 'day': json.load(config_file)['day']}
+    for _ in range(args.repeats):
+        for strategy in strategies:
+            if os.path.exists(perf_stats_path(strategy)):
+                os.remove(perf_stats_path(strategy))
+        log_path = os.path.join(work_dir, name + '.log')
+        start = time.time()
+        exit_code, peak_rss_kb = launch(config_path, log_path)
+        wall_time = time.time() - start
+        if exit_code != 0:
+            print('-- Bench FAILED: scenario %s exited with code %d, see %s' % (name, exit_code, log_path))
+            sys.exit(1)
+        if peak_rss_kb is not None:
+            result['peak_rss_kb'] = max(result.get('peak_rss_kb', 0), peak_rss_kb)
+        if 'wall_time_s' not in result or wall_time < result['wall_time_s']:
+            result['wall_time_s'] = wall_time
+            stats = read_perf_stats(strategies)
+    if not strategies:
+        return result
+
+    # Strategies of a duel get the same book updates, so the slowest replay is reported rather than a sum.
+    book_updates = max(stats[strategy]['counters']['book_updates'] for strategy in strategies)
+    replay_ns = max(stats[strategy]['counters']['replay_ns'] for strategy in strategies)
+    result['book_updates'] = book_updates
+    result['replay_s'] = replay_ns / 1e9
+    if book_updates > 0 and replay_ns > 0:
+        result['book_updates_per_sec'] = book_updates * 1e9 / replay_ns
+        result['ns_per_book_update'] = float(replay_ns) / book_updates
+    result['callbacks'] = dict(('%s.%s' % (strategy, timer_name), timer)
+                               for strategy in strategies
+                               for timer_name, timer in stats[strategy].get('timers', {}).items()
+                               if timer['count'] > 0)
+    return result
+
+
+def compare(results, baseline):
+    regressions = []
+    for name, result in sorted(results.items()):
+        expected_result = baseline.get(name)
+        if expected_result is None:
+            print('  %-12s not in the baseline' % name)
+            continue
+        if expected_result.get('day') != result['day']:
+            print('  %-12s skipped: baseline day %s, current day %s' % (name, expected_result.get('day'), result['day']))
+            continue
+        for metric in COMPARED_METRICS:
+            expected = expected_result.get(metric)
+            actual = result.get(metric)
+            if expected is None or actual is None:
+                continue
+            change = float(actual) / expected - 1 if expected else 0.0
+            status = 'REGRESSION' if change > args.tolerance else 'ok'
+            print('  %-12s %-20s %14.3f -> %14.3f  %+7.1f%%  %s' %
+                  (name, metric, expected, actual, change * 100, status))
+            if status != 'ok':
+                regressions.append('%s.%s' % (name, metric))
+    return regressions
+
+
+if not os.path.exists(work_dir):
+    os.makedirs(work_dir)
+output_dir = os.path.dirname(os.path.realpath(args.output))
+if not os.path.exists(output_dir):
+    os.makedirs(output_dir)
+
+selected = set(args.scenario or [name for name, _, _ in SCENARIOS])
+results = {}
+for name, config_path, strategies in SCENARIOS:
+    if name not in selected:
+        continue
+    print('-- Bench: running %s (%s, %d runs)' % (name, config_path, args.repeats))
+    results[name] = run_scenario(name, config_path, strategies)
+
+with open(args.output, 'w') as output_file:
+    json.dump(results, output_file, indent=2, separators=(',', ': '), sort_keys=True)
+print('-- Bench: results are written to %s' % args.output)
+
+if args.update_baseline:
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+    baseline.update(results)
+    with open(args.baseline, 'w') as baseline_file:
+        json.dump(baseline, baseline_file, indent=2, separators=(',', ': '), sort_keys=True)
+    print('-- Bench: baseline %s is updated' % args.baseline)
+    sys.exit()
+
+if not os.path.exists(args.baseline):
+    # No baseline has been recorded on the reference machine yet, so there is nothing to compare with.
+    print('-- Bench WARNING: baseline %s is not found, regressions are not checked. '
+          'Run ./bench.py --update-baseline on the reference machine and commit the file.' % args.baseline)
+    sys.exit()
+
+with open(args.baseline) as baseline_file:
+    regressions = compare(results, json.load(baseline_file))
+if regressions:
+    print('-- Bench FAILED: %s grew by more than %.0f%%' % (', '.join(regressions), args.tolerance * 100))
+    sys.exit(1)
@@ -1,17 +1,51 @@
 #!/usr/bin/env python
 
 from __future__ import print_function
+import argparse
+import collections
+import glob
+import json
 import multiprocessing
 import os
 import platform
+import shutil
+import signal
 import subprocess
 import sys
+import time
 
 reload(sys)
 sys.setdefaultencoding('utf8')
 
+USAGE_EXAMPLES = """\
+examples:
+  ./build.py
+  ./build.py --mode debug
+  ./build.py --std 17 --native
+  ./build.py --pgo user_strategy --train-day 2016.09.02 --eval-day 2016.09.01"""
+
+parser = argparse.ArgumentParser(epilog=USAGE_EXAMPLES, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--mode', choices=['release', 'debug'], default='release', help='build type')
+parser.add_argument('--std', choices=['14', '17', '20'], default='14',
+                    help='C++ standard: 17 needs GCC 7+ or Clang 5+, 20 needs GCC 10+ or Clang 10+')
+parser.add_argument('--native', action='store_true', help='optimise for the CPU of this machine (-march=native)')
+parser.add_argument('--pgo-stage', choices=['generate', 'use'], help='build a single profile-guided optimisation stage')
+parser.add_argument('--pgo', metavar='STRATEGY',
+                    help='profile-guided optimisation pipeline: build instrumented strategies, '
+                         'simulate STRATEGY on --train-day, rebuild with the profile '
+                         'and compare simulation time on --eval-day')
+parser.add_argument('--train-day', help='day to collect the profile on')
+parser.add_argument('--eval-day', help='held-out day to measure the speedup on')
+parser.add_argument('--pgo-repeats', type=int, default=3,
+                    help='simulations of --eval-day per build, the fastest one is compared')
+args, cmake_args = parser.parse_known_args()
+if args.pgo and not (args.train_day and args.eval_day):
+    parser.error('--pgo requires --train-day and --eval-day')
+
 pack_path = os.path.dirname(os.path.realpath(__file__))
 build_dir = os.path.join(pack_path, "build")
+pgo_dir = os.path.join(build_dir, "pgo_profiles")
+perf_stats_path = os.path.join(build_dir, "pgo_perf_stats.json")
 if not os.path.exists(build_dir):
     os.makedirs(build_dir)
 os.chdir(build_dir)
@@ -30,16 +64,136 @@ elif system == 'Darwin':
                         'brew install cmake'
     command = ["cmake", "..", "-DCMAKE_C_COMPILER=/usr/bin/gcc", "-DCMAKE_CXX_COMPILER=/usr/bin/g++"]
 
-try:
-    process = subprocess.Popen(command, shell=False, stdout=subprocess.PIPE)
+command += [
+    "-DCMAKE_BUILD_TYPE=%s" % ('Debug' if args.mode == 'debug' else 'Release'),
+    "-DHFTBATTLE_CXX_STANDARD=%s" % args.std,
+    "-DHFTBATTLE_MARCH_NATIVE=%s" % ('ON' if args.native else 'OFF'),
+    "-DHFTBATTLE_PGO_DIR=%s" % pgo_dir,
+]
+# Other arguments are passed to CMake as is, e.g. ./build.py -DHFTBATTLE_USDT=ON
+command += cmake_args
+
+
+def print_output(process):
     for line in iter(process.stdout.readline, b''):
         sys.stdout.write(line.decode())
-except Exception as ex:
-    print('-- Build FAILED: %s' % str(ex))
-    print('CMake is probably not installed.\n%s' % cmake_install_cmd)
+    return process.wait()
+
+
+def build(pgo_stage):
+    try:
+        process = subprocess.Popen(command + ["-DHFTBATTLE_PGO=%s" % (pgo_stage or '')], shell=False, stdout=subprocess.PIPE)
+        configure_exit_code = print_output(process)
+    except Exception as ex:
+        print('-- Build FAILED: %s' % str(ex))
+        print('CMake is probably not installed.\n%s' % cmake_install_cmd)
+        sys.exit(1)
+    if configure_exit_code != 0:
+        print('-- Build FAILED: CMake configuration failed')
+        sys.exit(1)
+
+    cpu_count = multiprocessing.cpu_count()
+    process = subprocess.Popen(["cmake", "--build", ".", "--target", "all", "--", "-j", str(cpu_count)], shell=False, stdout=subprocess.PIPE)
+    if print_output(process) != 0:
+        print('-- Build FAILED')
+        sys.exit(1)
+
+
+def restore_config(config_path):
+    # The backup is left only if a previous run was killed while the config was replaced.
+    backup_path = os.path.join(build_dir, os.path.basename(config_path) + '.orig')
+    if os.path.exists(backup_path):
+        shutil.copyfile(backup_path, config_path)
+        os.remove(backup_path)
+    return backup_path
+
+
+def simulate(strategy, day, repeats=1):
+    # The launcher takes the day from the strategy config, so it is replaced for the time of the run.
+    # Returns the best whole-process wall time of the runs and the best replay time in seconds,
+    # which is None unless the strategy is wrapped into BenchStrategy (include/bench_strategy.h).
+    config_path = os.path.join(pack_path, 'strategies', strategy, strategy + '.json')
+    backup_path = restore_config(config_path)
+    with open(config_path) as config_file:
+        config = json.load(config_file, object_pairs_hook=collections.OrderedDict)
+    config['day'] = day
+    config['perf_stats_file'] = perf_stats_path
+    shutil.copyfile(config_path, backup_path)
+    try:
+        with open(config_path, 'w') as config_file:
+            json.dump(config, config_file, indent=2, separators=(',', ': '))
+            config_file.write('\n')
+        best_time = None
+        best_replay_time = None
+        for _ in range(repeats):
+            if os.path.exists(perf_stats_path):
+                os.remove(perf_stats_path)
+            start = time.time()
+            if subprocess.call([sys.executable, os.path.join(pack_path, 'run.py'), strategy], cwd=pack_path) != 0:
+                print('-- PGO FAILED: simulation of %s on %s failed' % (strategy, day))
+                sys.exit(1)
+            run_time = time.time() - start
+            best_time = run_time if best_time is None else min(best_time, run_time)
+            replay_time = read_replay_time()
+            if replay_time is not None:
+                best_replay_time = replay_time if best_replay_time is None else min(best_replay_time, replay_time)
+        return best_time, best_replay_time
+    finally:
+        restore_config(config_path)
+
+
+def read_replay_time():
+    # BenchStrategy stores the time from the first to the end of the last callback as the "replay_ns" counter.
+    if not os.path.exists(perf_stats_path):
+        return None
+    with open(perf_stats_path) as stats_file:
+        replay_ns = json.load(stats_file).get('counters', {}).get('replay_ns')
+    return replay_ns / 1e9 if replay_ns else None
+
+
+def merge_clang_profiles():
+    raw_profiles = glob.glob(os.path.join(pgo_dir, '*.profraw'))
+    if raw_profiles:
+        # Xcode doesn't put llvm-profdata on PATH.
+        llvm_profdata = ['xcrun', 'llvm-profdata'] if system == 'Darwin' else ['llvm-profdata']
+        subprocess.check_call(llvm_profdata + ['merge', '-o', os.path.join(pgo_dir, 'default.profdata')] + raw_profiles)
+
+
+if not args.pgo:
+    build(args.pgo_stage)
     sys.exit()
 
-cpu_count = multiprocessing.cpu_count()
-process = subprocess.Popen(["cmake", "--build", ".", "--target", "all", "--", "-j", str(cpu_count)], shell=False, stdout=subprocess.PIPE)
-for line in iter(process.stdout.readline, b''):
-    sys.stdout.write(line.decode())
+# SIGTERM unwinds like an error, so the strategy config is restored.
+signal.signal(signal.SIGTERM, lambda signum, frame: sys.exit(1))
+
+if os.path.exists(pgo_dir):
+    shutil.rmtree(pgo_dir)
+os.makedirs(pgo_dir)
+
+print('-- PGO: building instrumented strategies')
+build('generate')
+print('-- PGO: collecting profile on %s' % args.train_day)
+simulate(args.pgo, args.train_day)
+merge_clang_profiles()
+if not os.listdir(pgo_dir):
+    print('-- PGO FAILED: no profile was collected in %s' % pgo_dir)
+    sys.exit(1)
+
+print('-- PGO: measuring baseline on %s' % args.eval_day)
+build(None)
+baseline_time, baseline_replay_time = simulate(args.pgo, args.eval_day, args.pgo_repeats)
+
+print('-- PGO: measuring optimised build on %s' % args.eval_day)
+build('use')
+pgo_time, pgo_replay_time = simulate(args.pgo, args.eval_day, args.pgo_repeats)
+
+# Only the strategy library is optimised, while the whole-process time also includes start-up and market data
+# decoding, so its ratio is diluted towards 1.0x.
+print('-- PGO: %s on %s, best of %d runs:' % (args.pgo, args.eval_day, args.pgo_repeats))
+if baseline_replay_time is not None and pgo_replay_time is not None:
+    print('-- PGO:   replay time (BenchStrategy replay_ns): baseline %.3f s, PGO %.3f s, speedup %.3fx' %
+          (baseline_replay_time, pgo_replay_time, baseline_replay_time / pgo_replay_time))
+else:
+    print('-- PGO:   replay time is not measured, wrap the strategy into BenchStrategy from include/bench_strategy.h')
+print('-- PGO:   whole-process wall time of run.py: baseline %.2f s, PGO %.2f s, ratio %.3fx' %
+      (baseline_time, pgo_time, baseline_time / pgo_time))
@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace hftbattle {
+
+// Log-linear histogram of non-negative values in the spirit of HdrHistogram.
+// Values below kSubBucketCount are counted exactly, larger ones with relative error below 1 / kSubBucketHalfCount.
+// Recording a value takes constant time and doesn't allocate memory.
+class LatencyHistogram {
+public:
+  static constexpr size_t kSubBucketBits = 6;
+  static constexpr size_t kSubBucketCount = size_t(1) << kSubBucketBits;
+  static constexpr size_t kSubBucketHalfCount = kSubBucketCount / 2;
+  static constexpr size_t kBucketsCount = kSubBucketCount + (63 - kSubBucketBits) * kSubBucketHalfCount;
+
+  LatencyHistogram() {
+    reset();
+  }
+
+  void record(int64_t value) {
+    value = std::max<int64_t>(value, 0);
+    ++counts_[bucket_index(static_cast<uint64_t>(value))];
+    ++total_count_;
+    sum_ += value;
+    max_ = std::max(max_, value);
+  }
+
+  void reset() {
+    counts_.fill(0);
+    total_count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+  }
+
+  uint64_t total_count() const {
+    return total_count_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  double mean() const {
+    return total_count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(total_count_);
+  }
+
+  // Takes a quantile from [0, 1].
+  // Returns the highest value equivalent (within the histogram precision) to the value at given quantile.
+  int64_t value_at_quantile(double quantile) const {
+    if (total_count_ == 0) {
+      return 0;
+    }
+    const double rank = std::ceil(std::min(std::max(quantile, 0.0), 1.0) * static_cast<double>(total_count_));
+    const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(rank), 1);
+    uint64_t seen = 0;
+    for (size_t index = 0; index < kBucketsCount; ++index) {
+      seen += counts_[index];
+      if (seen >= target) {
+        return std::min(bucket_highest_value(index), max_);
+      }
+    }
+    return max_;
+  }
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+    const size_t shift = 64 - static_cast<size_t>(__builtin_clzll(value)) - kSubBucketBits;
+    return kSubBucketCount + (shift - 1) * kSubBucketHalfCount +
+        static_cast<size_t>((value >> shift) - kSubBucketHalfCount);
+  }
+
+  static int64_t bucket_highest_value(size_t index) {
+    if (index < kSubBucketCount) {
+      return static_cast<int64_t>(index);
+    }
+    const size_t shift = (index - kSubBucketCount) / kSubBucketHalfCount + 1;
+    const uint64_t sub_bucket = (index - kSubBucketCount) % kSubBucketHalfCount + kSubBucketHalfCount;
+    return static_cast<int64_t>(((sub_bucket + 1) << shift) - 1);
+  }
+
+private:
+  std::array<uint64_t, kBucketsCount> counts_;
+  uint64_t total_count_;
+  int64_t sum_;
+  int64_t max_;
+};
+
+}  // namespace hftbattle
@@ -0,0 +1,16 @@
+#pragma once
+
+// Static user-space tracepoints (SystemTap SDT compatible) for perf, bpftrace and other USDT consumers.
+// Probes are compiled in only when HFTBATTLE_USDT is defined (`cmake -DHFTBATTLE_USDT=ON`, requires sys/sdt.h),
+// otherwise HFTBATTLE_PROBE expands to nothing.
+// An enabled probe costs a single nop instruction until a tracer attaches to it.
+// Probe arguments must be integers or pointers.
+// Usage example:
+//   HFTBATTLE_PROBE(book_update_begin, order_book.server_time().count());
+// List probes of your strategy: `readelf -n build/user_strategy/libuser_strategy.so`.
+#ifdef HFTBATTLE_USDT
+#include <sys/sdt.h>
+#define HFTBATTLE_PROBE(name, ...) STAP_PROBEV(hftbattle, name, ##__VA_ARGS__)
+#else
+#define HFTBATTLE_PROBE(name, ...) do { } while (false)
+#endif
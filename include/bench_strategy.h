@@ -0,0 +1,80 @@
+#pragma once
+#include "participant_strategy.h"
+#include "perf_stats.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hftbattle {
+
+// This class wraps a strategy to measure it with bench.py.
+// Every callback is timed, book updates are counted, and the time from the first to the end of the last callback
+// is stored as the "replay_ns" counter: unlike the wall time of the launcher it excludes start-up and shutdown.
+// The stats are dumped as JSON to config["perf_stats_file"] when the strategy is destroyed.
+// Usage example:
+//   REGISTER_CONTEST_STRATEGY(BenchStrategy<UserStrategy>, user_strategy)
+template<typename Strategy>
+class BenchStrategy : public Strategy {
+public:
+  explicit BenchStrategy(const JsonValue& config) :
+      Strategy(config),
+      perf_stats_(config["perf_stats_file"].as<std::string>(""), this->getCurrentLoggerId()),
+      book_update_timer_(perf_stats_.add_timer("trading_book_update")),
+      deals_update_timer_(perf_stats_.add_timer("trading_deals_update")),
+      execution_report_timer_(perf_stats_.add_timer("execution_report_update")),
+      book_updates_counter_(perf_stats_.add_counter("book_updates")),
+      replay_ns_counter_(perf_stats_.add_counter("replay_ns")),
+      first_callback_start_(Ticks::zero()),
+      last_callback_end_(Ticks::zero()) { }
+
+  ~BenchStrategy() override {
+    const int64_t replay_ticks = (last_callback_end_ - first_callback_start_).count();
+    perf_stats_.increment(replay_ns_counter_, replay_ticks * 1000 / Ticks::get_ticks_in_microsecond());
+  }
+
+  void trading_book_update(const OrderBook& order_book) override {
+    mark_callback_start();
+    {
+      ScopedPerfTimer timer(perf_stats_, book_update_timer_);
+      Strategy::trading_book_update(order_book);
+    }
+    perf_stats_.increment(book_updates_counter_);
+    last_callback_end_ = rdtsc();
+  }
+
+  void trading_deals_update(std::vector<Deal>&& deals) override {
+    mark_callback_start();
+    {
+      ScopedPerfTimer timer(perf_stats_, deals_update_timer_);
+      Strategy::trading_deals_update(std::move(deals));
+    }
+    last_callback_end_ = rdtsc();
+  }
+
+  void execution_report_update(const ExecutionReport& execution_report) override {
+    mark_callback_start();
+    {
+      ScopedPerfTimer timer(perf_stats_, execution_report_timer_);
+      Strategy::execution_report_update(execution_report);
+    }
+    last_callback_end_ = rdtsc();
+  }
+
+private:
+  void mark_callback_start() {
+    if (!first_callback_start_) {
+      first_callback_start_ = rdtsc();
+    }
+  }
+
+  PerfStats perf_stats_;
+  const PerfTimerId book_update_timer_;
+  const PerfTimerId deals_update_timer_;
+  const PerfTimerId execution_report_timer_;
+  const PerfCounterId book_updates_counter_;
+  const PerfCounterId replay_ns_counter_;
+  Ticks first_callback_start_;
+  Ticks last_callback_end_;
+};
+
+}  // namespace hftbattle
@@ -0,0 +1,203 @@
+#pragma once
+#include "base/json.h"
+#include "base/latency_histogram.h"
+#include "base/log.h"
+#include "base/perf_time.h"
+#include "base/probes.h"
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hftbattle {
+
+using PerfTimerId = size_t;
+using PerfCounterId = size_t;
+
+// This class collects latency histograms and counters of your own code.
+// Register timers and counters once (e.g. in the constructor of your strategy) and keep returned ids:
+// recording by id takes constant time and doesn't allocate memory.
+// When the object is destroyed, the report with p50/p99/p99.9/max in nanoseconds is written with SCREEN() to the log
+// of the given logger (the anonymous one by default) and dumped as JSON to json_filename, if it's not empty.
+// Pass the logger of your strategy, so the report lands in its log and can be told apart from other strategies.
+// Usage example:
+//   PerfStats perf_stats_{config["perf_stats_file"].as<std::string>(""), getCurrentLoggerId()};
+//   PerfTimerId book_update_timer_ = perf_stats_.add_timer("trading_book_update");
+//
+//   void trading_book_update(const OrderBook& order_book) override {
+//     ScopedPerfTimer timer(perf_stats_, book_update_timer_);
+//     ...
+//   }
+class PerfStats {
+public:
+  explicit PerfStats(std::string json_filename = "", LoggerId logger = nullptr) :
+      json_filename_(std::move(json_filename)),
+      logger_(logger != nullptr ? logger : Logger::anonymous()) { }
+
+  PerfStats(const PerfStats&) = delete;
+  PerfStats& operator=(const PerfStats&) = delete;
+
+  ~PerfStats() {
+    if (timer_names_.empty() && counter_names_.empty()) {
+      return;
+    }
+    try {
+      log_report();
+      if (!json_filename_.empty()) {
+        write_json(json_filename_);
+      }
+    } catch (const std::exception& ex) {
+      ERROR() << "Failed to write perf stats: " << ex.what();
+    }
+  }
+
+  // Takes a name of the timer.
+  // Returns an id of the timer with given name, the timer is registered on the first call.
+  PerfTimerId add_timer(const std::string& name) {
+    const size_t id = find_or_add_name(timer_names_, name);
+    histograms_.resize(timer_names_.size());
+    return id;
+  }
+
+  // Takes a name of the counter.
+  // Returns an id of the counter with given name, the counter is registered on the first call.
+  PerfCounterId add_counter(const std::string& name) {
+    const size_t id = find_or_add_name(counter_names_, name);
+    counters_.resize(counter_names_.size(), 0);
+    return id;
+  }
+
+  // Takes an id of the timer and a measured duration.
+  // Adds the duration to the timer histogram.
+  void record(PerfTimerId id, Ticks duration) {
+    histograms_[id].record(duration.count());
+  }
+
+  // Takes an id of the counter and a value.
+  // Adds the value to the counter.
+  void increment(PerfCounterId id, int64_t value = 1) {
+    counters_[id] += value;
+  }
+
+  // Takes an id of the timer.
+  // Returns a histogram of durations in ticks.
+  const LatencyHistogram& histogram(PerfTimerId id) const {
+    return histograms_[id];
+  }
+
+  // Takes an id of the timer.
+  // Returns the name the timer was registered with.
+  const std::string& timer_name(PerfTimerId id) const {
+    return timer_names_[id];
+  }
+
+  // Takes an id of the counter.
+  // Returns current counter value.
+  int64_t counter(PerfCounterId id) const {
+    return counters_[id];
+  }
+
+  // Writes the report to the log, one line per timer and counter.
+  void log_report() const {
+    if (json_filename_.empty()) {
+      SCREEN() << "Perf stats of [" << getCurrentLoggerId()->name() << "]:";
+    } else {
+      SCREEN() << "Perf stats of [" << getCurrentLoggerId()->name() << "], dumped to " << json_filename_ << ":";
+    }
+    for (size_t id = 0; id < timer_names_.size(); ++id) {
+      const LatencyHistogram& histogram = histograms_[id];
+      SCREEN() << "  " << timer_names_[id] <<
+          ": count " << histogram.total_count() <<
+          ", mean " << ticks_to_nanoseconds(static_cast<int64_t>(histogram.mean())) << " ns" <<
+          ", p50 " << quantile_ns(histogram, 0.5) << " ns" <<
+          ", p99 " << quantile_ns(histogram, 0.99) << " ns" <<
+          ", p99.9 " << quantile_ns(histogram, 0.999) << " ns" <<
+          ", max " << ticks_to_nanoseconds(histogram.max()) << " ns";
+    }
+    for (size_t id = 0; id < counter_names_.size(); ++id) {
+      SCREEN() << "  " << counter_names_[id] << ": " << counters_[id];
+    }
+  }
+
+  JsonValue to_json() const {
+    JsonValue json(JsonValueType::Object);
+    for (size_t id = 0; id < timer_names_.size(); ++id) {
+      const LatencyHistogram& histogram = histograms_[id];
+      auto&& timer = json["timers"][timer_names_[id]];
+      timer["count"] = static_cast<long long>(histogram.total_count());
+      timer["mean_ns"] = static_cast<long long>(ticks_to_nanoseconds(static_cast<int64_t>(histogram.mean())));
+      timer["p50_ns"] = static_cast<long long>(quantile_ns(histogram, 0.5));
+      timer["p99_ns"] = static_cast<long long>(quantile_ns(histogram, 0.99));
+      timer["p99.9_ns"] = static_cast<long long>(quantile_ns(histogram, 0.999));
+      timer["max_ns"] = static_cast<long long>(ticks_to_nanoseconds(histogram.max()));
+    }
+    for (size_t id = 0; id < counter_names_.size(); ++id) {
+      json["counters"][counter_names_[id]] = static_cast<long long>(counters_[id]);
+    }
+    return json;
+  }
+
+  void write_json(const std::string& filename) const {
+    std::ofstream out(filename);
+    CHECK(out.is_open(), "Can't open perf stats file: '" << filename << "'");
+    out << to_json().to_styled_string();
+  }
+
+private:
+  // Makes SCREEN() and ERROR() write to the owner's logger, like in LoggableComponent.
+  LoggerId getCurrentLoggerId() const {
+    return logger_;
+  }
+
+  static size_t find_or_add_name(std::vector<std::string>& names, const std::string& name) {
+    for (size_t id = 0; id < names.size(); ++id) {
+      if (names[id] == name) {
+        return id;
+      }
+    }
+    names.push_back(name);
+    return names.size() - 1;
+  }
+
+  static int64_t ticks_to_nanoseconds(int64_t ticks) {
+    return ticks * 1000 / Ticks::get_ticks_in_microsecond();
+  }
+
+  static int64_t quantile_ns(const LatencyHistogram& histogram, double quantile) {
+    return ticks_to_nanoseconds(histogram.value_at_quantile(quantile));
+  }
+
+  std::string json_filename_;
+  const LoggerId logger_;
+  std::vector<std::string> timer_names_;
+  std::vector<LatencyHistogram> histograms_;
+  std::vector<std::string> counter_names_;
+  std::vector<int64_t> counters_;
+};
+
+// Measures time from its construction to its destruction and records it to the given timer.
+class ScopedPerfTimer {
+public:
+  ScopedPerfTimer(PerfStats& stats, PerfTimerId id) : stats_(stats), id_(id), start_(rdtsc()) {
+    HFTBATTLE_PROBE(perf_timer_begin, stats_.timer_name(id_).c_str());
+  }
+
+  ScopedPerfTimer(const ScopedPerfTimer&) = delete;
+  ScopedPerfTimer& operator=(const ScopedPerfTimer&) = delete;
+
+  ~ScopedPerfTimer() {
+    const Ticks duration = rdtsc() - start_;
+    HFTBATTLE_PROBE(perf_timer_end, stats_.timer_name(id_).c_str(), duration.count());
+    stats_.record(id_, duration);
+  }
+
+private:
+  PerfStats& stats_;
+  const PerfTimerId id_;
+  const Ticks start_;
+};
+
+}  // namespace hftbattle
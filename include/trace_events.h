@@ -0,0 +1,176 @@
+#pragma once
+#include "base/log.h"
+#include "base/perf_time.h"
+#include "base/probes.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hftbattle {
+
+// This class records spans of your code as a trace in Chrome trace event format.
+// The trace can be viewed offline in <https://ui.perfetto.dev> or chrome://tracing.
+// Each span is stamped both with wall-clock time (rdtsc ticks) and with simulated server time.
+// To keep the file size bounded, at most max_spans spans are stored, only every sample_every-th span is recorded,
+// and recording can be limited by a server time window.
+// Note: span names are stored as pointers, so use string literals or strings which outlive the writer.
+// The trace is written to filename when the object is destroyed.
+// Usage example:
+//   TraceWriter trace_{"trace.json"};
+//
+//   void trading_book_update(const OrderBook& order_book) override {
+//     ScopedTraceSpan span(trace_, "trading_book_update", order_book.server_time());
+//     ...
+//   }
+class TraceWriter {
+public:
+  explicit TraceWriter(std::string filename, size_t max_spans = 1000000, size_t sample_every = 1) :
+      filename_(std::move(filename)),
+      max_spans_(max_spans),
+      sample_every_(std::max<size_t>(sample_every, 1)),
+      window_begin_(Microseconds::min()),
+      window_end_(Microseconds::max()),
+      candidates_count_(0),
+      dropped_spans_count_(0) {
+    spans_.reserve(max_spans_ < kInitialSpansCapacity ? max_spans_ : kInitialSpansCapacity);
+  }
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  ~TraceWriter() {
+    if (filename_.empty()) {
+      return;
+    }
+    try {
+      std::ofstream out(filename_);
+      CHECK(out.is_open(), "Can't open trace file: '" << filename_ << "'");
+      write(out);
+    } catch (const std::exception& ex) {
+      ERROR() << "Failed to write trace: " << ex.what();
+    }
+  }
+
+  // Takes the first and the last server time of spans to record.
+  void set_server_time_window(Microseconds begin, Microseconds end) {
+    window_begin_ = begin;
+    window_end_ = end;
+  }
+
+  // Takes a server time of the span start.
+  // Returns bool value — whether the span must be recorded.
+  bool should_record(Microseconds server_time) {
+    if (server_time < window_begin_ || server_time > window_end_) {
+      return false;
+    }
+    if (candidates_count_++ % sample_every_ != 0) {
+      return false;
+    }
+    if (spans_.size() >= max_spans_) {
+      ++dropped_spans_count_;
+      return false;
+    }
+    return true;
+  }
+
+  void add_span(const char* name, Ticks start, Ticks end, Microseconds server_time) {
+    spans_.push_back({name, start, end, server_time});
+  }
+
+  // Returns a number of spans which were not recorded because of max_spans limit.
+  size_t dropped_spans_count() const {
+    return dropped_spans_count_;
+  }
+
+  void write(std::ostream& out) const {
+    // Spans are stored in the order they end, so an enclosing span starts before the first stored one.
+    Ticks origin = spans_.empty() ? Ticks::zero() : spans_.front().start;
+    for (const Span& span : spans_) {
+      origin = std::min(origin, span.start);
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (size_t i = 0; i < spans_.size(); ++i) {
+      const Span& span = spans_[i];
+      out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+      write_escaped(out, span.name);
+      out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1" <<
+          ",\"ts\":" << ticks_to_microseconds(span.start - origin) <<
+          ",\"dur\":" << ticks_to_microseconds(span.end - span.start) <<
+          ",\"args\":{\"server_time_us\":" << span.server_time.count() <<
+          ",\"tsc\":" << span.start.count() << "}}";
+    }
+    out << "\n],\"otherData\":{\"dropped_spans\":" << dropped_spans_count_ << "}}\n";
+  }
+
+private:
+  // The buffer grows on demand up to max_spans, so a writer with the default limit doesn't take ~32 MB up front.
+  static constexpr size_t kInitialSpansCapacity = 4096;
+
+  struct Span {
+    const char* name;
+    Ticks start;
+    Ticks end;
+    Microseconds server_time;
+  };
+
+  static double ticks_to_microseconds(Ticks ticks) {
+    return static_cast<double>(ticks.count()) / static_cast<double>(Ticks::get_ticks_in_microsecond());
+  }
+
+  static void write_escaped(std::ostream& out, const char* str) {
+    for (; *str != '\0'; ++str) {
+      if (*str == '"' || *str == '\\') {
+        out << '\\';
+      }
+      out << *str;
+    }
+  }
+
+  const std::string filename_;
+  const size_t max_spans_;
+  const size_t sample_every_;
+  Microseconds window_begin_;
+  Microseconds window_end_;
+  size_t candidates_count_;
+  size_t dropped_spans_count_;
+  std::vector<Span> spans_;
+};
+
+// Records a span from its construction to its destruction, if the writer decides to record it.
+class ScopedTraceSpan {
+public:
+  ScopedTraceSpan(TraceWriter& writer, const char* name, Microseconds server_time) :
+      writer_(writer.should_record(server_time) ? &writer : nullptr),
+      name_(name),
+      server_time_(server_time),
+      start_(writer_ != nullptr ? rdtsc() : Ticks::zero()) {
+    HFTBATTLE_PROBE(trace_span_begin, name_, server_time_.count());
+  }
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+  ~ScopedTraceSpan() {
+    HFTBATTLE_PROBE(trace_span_end, name_, server_time_.count());
+    if (writer_ != nullptr) {
+      writer_->add_span(name_, start_, rdtsc(), server_time_);
+    }
+  }
+
+private:
+  TraceWriter* const writer_;
+  const char* const name_;
+  const Microseconds server_time_;
+  const Ticks start_;
+};
+
+}  // namespace hftbattle
@@ -1,5 +1,6 @@
 #!/usr/bin/env python
 
+import multiprocessing
 import os
 import sys
 import subprocess
@@ -13,25 +14,15 @@ Please, specify strategy name or path to your strategy config. For example:
   ./run.py strategies/sample_strategy/sample_strategy.json
 
 To run a duel specify path to your duel config:
-  ./run.py duels_config.json"""
+  ./run.py duels_config.json
+
+To run several configs in parallel, each in its own process, list them all:
+  ./run.py base_strategy improved_strategy"""
     print(USAGE)
 
 
 script_path = os.path.dirname(os.path.realpath(__file__))
 
-if len(sys.argv) != 2:
-    print_usage()
-    sys.exit()
-
-config = sys.argv[1]
-if not config.endswith('.json'):
-    config = 'strategies/%s/%s.json' % (config, config)
-
-if not os.path.exists(os.path.join(script_path, config)):
-    print("ERROR: config %s doesn't exist\n" % config)
-    print_usage()
-    sys.exit()
-
 executable_name = ''
 system = platform.system()
 if system == 'Linux':
@@ -40,11 +31,57 @@ elif system == 'Darwin':
     executable_name = 'mac_launcher'
 elif system == 'Windows':
     executable_name = 'windows_launcher.exe'
-else:
-    print('Your OS is not supported')
-    sys.exit()
 
 executable_path = os.path.join(script_path, executable_name)
-process = subprocess.Popen([executable_path, config], shell=False, stdout=subprocess.PIPE, env=dict(os.environ, PYTHONPATH="."))
-for line in iter(process.stdout.readline, b''):
-    sys.stdout.write(line.decode())
+env = dict(os.environ, PYTHONPATH=".")
+
+
+def run_config(config):
+    process = subprocess.Popen([executable_path, config], shell=False, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, env=env)
+    output = process.communicate()[0].decode()
+    return config, output, process.returncode
+
+
+def main():
+    if len(sys.argv) < 2:
+        print_usage()
+        sys.exit()
+
+    configs = []
+    for config in sys.argv[1:]:
+        if not config.endswith('.json'):
+            config = 'strategies/%s/%s.json' % (config, config)
+        if not os.path.exists(os.path.join(script_path, config)):
+            print("ERROR: config %s doesn't exist\n" % config)
+            print_usage()
+            sys.exit()
+        configs.append(config)
+
+    if not executable_name:
+        print('Your OS is not supported')
+        sys.exit()
+
+    if len(configs) == 1:
+        process = subprocess.Popen([executable_path, configs[0]], shell=False, stdout=subprocess.PIPE, env=env)
+        for line in iter(process.stdout.readline, b''):
+            sys.stdout.write(line.decode())
+        sys.exit(process.wait())
+
+    # Every simulation runs in its own launcher process, so Python strategies don't share an interpreter.
+    pool = multiprocessing.Pool(min(len(configs), multiprocessing.cpu_count()))
+    failed_configs = []
+    for config, output, exit_code in pool.imap(run_config, configs):
+        print('==> %s' % config)
+        sys.stdout.write(output)
+        if exit_code != 0:
+            failed_configs.append(config)
+    pool.close()
+    pool.join()
+    if failed_configs:
+        print('ERROR: simulation failed for %s' % ', '.join(failed_configs))
+        sys.exit(1)
+
+
+# Pool workers import this module when processes are spawned (Windows, macOS), so it must not run on import.
+if __name__ == '__main__':
+    main()
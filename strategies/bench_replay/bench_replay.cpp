@@ -0,0 +1,15 @@
+#include "bench_strategy.h"
+
+using namespace hftbattle;
+
+namespace {
+
+// Benchmark scenario of bench.py: pure market data replay, no orders are sent.
+class UserStrategy : public ParticipantStrategy {
+public:
+  explicit UserStrategy(const JsonValue& /*config*/) { }
+};
+
+}  // namespace
+
+REGISTER_CONTEST_STRATEGY(BenchStrategy<UserStrategy>, bench_replay)
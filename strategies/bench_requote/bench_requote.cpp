@@ -0,0 +1,58 @@
+#include "bench_strategy.h"
+
+using namespace hftbattle;
+
+namespace {
+
+// Benchmark scenario of bench.py: requoting around the middle price, a frozen copy of base_strategy.
+// It is kept separate so that editing the sample strategy doesn't change the benchmark.
+class UserStrategy : public ParticipantStrategy {
+public:
+  UserStrategy(const JsonValue& config) :
+      volume_(config["volume"].as<Amount>(1)),
+      max_pos_(config["max_pos"].as<Amount>(1)),
+      offset_(config["offset"].as<Price>(18)) {
+    set_max_total_amount(max_pos_);
+  }
+
+  Amount max_available_order_amount(Amount pos, Dir dir) {
+    Amount max_amount = std::min(max_pos_ - dir_sign(dir) * pos, volume_);
+    return std::max(0, max_amount);
+  }
+
+  void trading_book_update(const OrderBook& order_book) override {
+    const auto& orders = order_book.orders();
+    Price middle_price = order_book.middle_price();
+    Amount pos = executed_amount();
+
+    add_chart_point("middle_price", middle_price);
+
+    for (Dir dir : {BID, ASK}) {
+      Price target_price = middle_price - dir_sign(dir) * offset_;
+      Amount order_amount = max_available_order_amount(pos, dir);
+
+      if (orders.active_orders_count(dir) == 0) {
+        if (order_amount > 0) {
+          add_limit_order(dir, target_price, order_amount);
+        }
+      } else {
+        Order* current_order = orders.orders_by_dir(dir).front();
+        if (current_order->price() != target_price) {
+          delete_order(current_order);
+          if (order_amount > 0) {
+            add_limit_order(dir, target_price, order_amount);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  Amount volume_;
+  Amount max_pos_;
+  Price offset_;
+};
+
+}  // namespace
+
+REGISTER_CONTEST_STRATEGY(BenchStrategy<UserStrategy>, bench_requote)